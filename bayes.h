@@ -32,8 +32,8 @@ static inline double norm_rand() {
 	return (double)rand() / RAND_MAX;
 }
 
-inline int random_draw(const double *pmf, int l) {
-	double r = norm_rand();
+/* Inverse transform draw for a given uniform r in [0,1]. */
+inline int random_draw(const double *pmf, int l, double r) {
 	double mass = 0.0;
 	for(int i=0;i<l;i++) {
 		mass += pmf[i];
@@ -44,6 +44,10 @@ inline int random_draw(const double *pmf, int l) {
 	return l-1;
 }
 
+inline int random_draw(const double *pmf, int l) {
+	return random_draw(pmf, l, norm_rand());
+}
+
 /* Draw n times from the distribution and take the maximum result. */
 vec n_draws(const vec *pmf, int n);
 
@@ -0,0 +1,194 @@
+#include <chrono>
+#include <random>
+#include <iostream>
+#include "float.h"
+#include "bench.h"
+#include "bayes.h"
+#include "utc.h"
+#include "parameters.h"
+
+using namespace std;
+using namespace arma;
+
+/* Common random numbers: every policy sees the same episodes.
+   episodes[k,0] draws the initial distance to the optimum,
+   episodes[k,p] the improvement in the p-th period. */
+static mat draw_episodes(int N, int periods, unsigned int seed) {
+	mt19937 gen(seed);
+	uniform_real_distribution<> dis(0.0, 1.0);
+	mat episodes(N, periods+1);
+	for(int k=0;k<N;k++)
+		for(int p=0;p<=periods;p++)
+			episodes.at(k,p) = dis(gen);
+	return episodes;
+}
+
+/* Greedy action in the UTC tree among the anodes that got real simulations.
+   Simulate() initialises every anode with N = 100 and the V_static prior,
+   which ignores the server cost, so anodes with N <= 100 are mostly prior.
+   If no anode of the node qualifies (or the observation was never simulated),
+   fall back to the static Bayes decision on the current belief. */
+static int utc_action(onode *node, const vec *belief, const mat *ims, int n) {
+	int best = -1;
+	float best_value = -FLT_MAX;
+	if(node != NULL) {
+		auto end = node->actions.end();
+		for(auto it = node->actions.begin(); it!=end; it++) {
+			if(it->second.N > 100 && it->second.V > best_value) {
+				best = it->second.action_index;
+				best_value = it->second.V;
+			}
+		}
+	}
+	if(best == -1)
+		return best_action(belief, ims, n, NULL);
+	return best;
+}
+
+/* Plays all episodes with one policy. Returns the value of every episode
+   and adds the time spent deciding online to *seconds. */
+static vec evaluate(solver s, onode *root, int static_action, const vec *initial_belief,
+		const mat *ims, int periods, const mat *episodes, double *seconds) {
+	int N = episodes->n_rows;
+	vec results(N);
+	chrono::duration<double> decision_time(0.0);
+
+	for(int k=0;k<N;k++) {
+		int o_pos = random_draw(initial_belief->memptr(), initial_belief->n_elem, episodes->at(k,0));
+		vec belief = *initial_belief;
+		onode *node = root;
+		double value = 0.0;
+
+		for(int n=periods;n>0;n--) {
+			auto start = chrono::steady_clock::now();
+			int action = static_action;
+			if(s == SOLVER_REPEATED_BAYES)
+				action = best_action(&belief, ims, n, NULL);
+			else if(s == SOLVER_UTC)
+				action = utc_action(node, &belief, ims, n);
+			decision_time += chrono::steady_clock::now() - start;
+
+			int improvement = random_draw(ims[action].colptr(o_pos), ims[action].n_rows, episodes->at(k,periods-n+1));
+			value += (double)improvement - (action * server_cost);
+			o_pos -= improvement;
+
+			if(n > 1) {
+				belief = belief_update(&belief, &ims[action], improvement);
+				if(node != NULL) {
+					onode *next = NULL;
+					auto an = node->actions.find(action);
+					if(an != node->actions.end()) {
+						auto on = an->second.observations.find(improvement);
+						if(on != an->second.observations.end())
+							next = &on->second;
+					}
+					node = next;
+				}
+			}
+		}
+		results.at(k) = value;
+	}
+
+	*seconds += decision_time.count() / N; // online time per episode
+	return results;
+}
+
+/* 97.5% quantile of Student's t distribution with df degrees of freedom. */
+static double t975(int df) {
+	static const double t[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	                           2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086};
+	if(df < 1) return 1.96;
+	if(df <= 20) return t[df-1];
+	return 1.96;
+}
+
+/* values and baseline hold one value per episode. The difference to the
+   baseline is paired per episode, as both played the same episodes.
+   search_means (UTC only, else NULL) holds the mean value of every search;
+   values are then the per-episode averages over these searches. The
+   episodes are shared by all searches, so the between-search variance is
+   added to the episode variance and the interval uses t with searches-1 df. */
+static void add_row(mat *table, int row, solver s, double budget, double seconds,
+		const vec *values, const vec *baseline, const vec *search_means) {
+	double n = (double)values->n_elem;
+	double m = mean(*values);
+	vec diff = *values - *baseline;
+	double dm = mean(diff);
+	double se2 = var(*values) / n; // squared standard error
+	double dse2 = var(diff) / n;
+	double q = 1.96;
+	double search_sd = 0.0, search_min = m, search_max = m;
+	if(search_means != NULL && search_means->n_elem > 1) {
+		double between = var(*search_means) / search_means->n_elem;
+		se2 += between;
+		dse2 += between; // the baseline is the same for every search
+		q = t975(search_means->n_elem - 1);
+		search_sd = stddev(*search_means);
+		search_min = search_means->min();
+		search_max = search_means->max();
+	}
+	double ci = q * sqrt(se2);
+	double dci = q * sqrt(dse2);
+	table->at(row,0) = s;
+	table->at(row,1) = budget;
+	table->at(row,2) = seconds;
+	table->at(row,3) = m;
+	table->at(row,4) = m - ci;
+	table->at(row,5) = m + ci;
+	table->at(row,6) = dm;
+	table->at(row,7) = dm - dci;
+	table->at(row,8) = dm + dci;
+	table->at(row,9) = search_sd;
+	table->at(row,10) = search_min;
+	table->at(row,11) = search_max;
+	cout << "solver " << s << " budget " << budget << "s used " << seconds << "s: "
+	     << m << " +- " << ci << ", vs. repeated Bayes " << dm << " +- " << dci
+	     << ", search means " << search_min << ".." << search_max << endl;
+}
+
+mat benchmark(const vec *belief, mat *ims, int periods) {
+	int N = 500;          // evaluation episodes
+	int searches = 10;    // independent UTC searches per budget
+	double budgets[] = {0.5, 1.0, 2.0, 4.0, 8.0};
+	int budget_count = sizeof(budgets)/sizeof(budgets[0]);
+	mat episodes = draw_episodes(N, periods, 42);
+	mat table(budget_count+2, 12);
+	int row = 0;
+
+	/* Static and repeated Bayes are exact and do not use the budget.
+	   Repeated Bayes is the baseline for the paired differences. */
+	double repeated_seconds = 0.0;
+	vec repeated = evaluate(SOLVER_REPEATED_BAYES, NULL, -1, belief, ims, periods, &episodes, &repeated_seconds);
+
+	auto static_start = chrono::steady_clock::now();
+	int static_action = best_action(belief, ims, periods, NULL);
+	chrono::duration<double> static_time = chrono::steady_clock::now() - static_start;
+	double static_seconds = static_time.count();
+	vec values = evaluate(SOLVER_STATIC_BAYES, NULL, static_action, belief, ims, periods, &episodes, &static_seconds);
+	add_row(&table, row++, SOLVER_STATIC_BAYES, 0.0, static_seconds, &values, &repeated, NULL);
+	add_row(&table, row++, SOLVER_REPEATED_BAYES, 0.0, repeated_seconds, &repeated, &repeated, NULL);
+
+	/* UTC: anytime, one point per budget. The searches replay the same
+	   episodes, so their values are averaged per episode; the spread of the
+	   search means enters the interval separately (see add_row). */
+	for(int b=0;b<budget_count;b++) {
+		values = zeros<vec>(N);
+		vec search_means(searches);
+		double seconds = 0.0;
+		for(int r=0;r<searches;r++) {
+			srand(r+1); // glibc: srand(0) == srand(1)
+			auto start = chrono::steady_clock::now();
+			utc_result res = Search(periods, belief, ims, budgets[b]);
+			chrono::duration<double> search_time = chrono::steady_clock::now() - start;
+			double used = search_time.count();
+			vec search_values = evaluate(SOLVER_UTC, res.root, -1, belief, ims, periods, &episodes, &used);
+			search_means.at(r) = mean(search_values);
+			values += search_values / searches;
+			seconds += used / searches;
+			delete res.root;
+		}
+		add_row(&table, row++, SOLVER_UTC, budgets[b], seconds, &values, &repeated, &search_means);
+	}
+
+	return table;
+}
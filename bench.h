@@ -0,0 +1,22 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <armadillo>
+
+using namespace arma;
+
+enum solver {
+	SOLVER_UTC,
+	SOLVER_STATIC_BAYES,
+	SOLVER_REPEATED_BAYES
+};
+
+/* Runs every solver under a list of wall-clock budgets and evaluates the
+   resulting policies on the same seeded Monte Carlo episodes.
+   Returns one row per (solver, budget):
+   solver, budget [s], time used [s], mean value, 95% CI low, 95% CI high,
+   paired difference to repeated Bayes, its 95% CI low, 95% CI high,
+   std. dev., min and max of the per-search means (UTC only) */
+mat benchmark(const vec *belief, mat *ims, int periods);
+
+#endif
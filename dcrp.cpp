@@ -3,6 +3,7 @@
 #include <armadillo>
 #include "bayes.h"
 #include "utc.h"
+#include "bench.h"
 #include "parameters.h"
 
 using namespace arma;
@@ -108,10 +109,18 @@ int main(int argc, char** argv) {
 		ims[i] = improvement_given_optimum(&values, unnormalised_transformed_exp_dist, i);
 	}
 
+	/* Solution quality versus time */
+	if(argc > 1 && string(argv[1]) == "bench") {
+		mat table = benchmark(&belief, ims, periods);
+		table.save("bench_results.dat", raw_ascii);
+		return 0;
+	}
+
 	/* UTC */
 	utc_result result = Search(periods, &belief, ims);
 	cout << "UTC best action: " << result.best_action << endl;
 	cout << "UTC best action value: " << result.best_value << endl;
+	cout << "UTC tree nodes: " << result.nodes << " (" << result.evictions << " evictions, " << result.evicted_nodes << " nodes freed)" << endl;
 	onode_show_N(result.root);
 	result.convergence.save("utc_convegence.dat", raw_ascii);
 	vec utc_res = MC_utc(result.root, &belief, ims, periods);
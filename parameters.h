@@ -4,5 +4,6 @@
 #define action_count 11
 #define observation_count 200 
 #define server_cost 3.0
+#define node_budget 1000000 // max. nodes (onodes + anodes) in the UTC tree, 0 = unbounded
 
 #endif /* PARAMETERS_H */
@@ -1,4 +1,7 @@
 #include <random>
+#include <chrono>
+#include <vector>
+#include <algorithm>
 #include "float.h"
 #include "utc.h"
 #include "parameters.h"
@@ -71,6 +74,60 @@ vec update_history_belief(onode *h, const vec *initial_belief, const mat *ims) {
 	return current_belief;
 }
 
+/* Node budget: once the tree grows beyond node_budget, the least visited
+   onodes are removed from their father anode (deepest first on ties) until
+   the tree is back to 3/4 of the budget. The father keeps its N and V, so the
+   statistics of the evicted subtree stay collapsed into it and the onode is
+   simply regrown if it gets visited again.
+   A descendant never has more visits than its ancestors. Ordered by N and
+   depth, it is therefore always erased before its ancestor and the pointers
+   of the remaining candidates stay valid.
+   With a deadline (timed Search()), erasing stops once it has passed, so a
+   pass costs at most one walk and sort of the tree beyond the budget.
+   Only Search() evicts: MC_utc() holds pointers into the tree and still grows
+   it without a cap. */
+struct evict_candidate {
+	onode *node;
+	int depth;
+};
+
+static void collect_candidates(onode *node, int depth, vector<evict_candidate> *candidates) {
+	auto aend = node->actions.end();
+	for(auto ait = node->actions.begin(); ait!=aend;ait++) {
+		anode *va = &ait->second;
+		auto oend = va->observations.end();
+		for(auto oit = va->observations.begin(); oit!=oend; oit++) {
+			candidates->push_back({&oit->second, depth+1});
+			collect_candidates(&oit->second, depth+1, candidates);
+		}
+	}
+}
+
+static void evict(onode *root, int *tree_nodes, int *evictions, int *evicted_nodes,
+		const chrono::steady_clock::time_point *deadline) {
+	vector<evict_candidate> candidates;
+	collect_candidates(root, 0, &candidates);
+	sort(candidates.begin(), candidates.end(), [](const evict_candidate &a, const evict_candidate &b) {
+		if(a.node->N != b.node->N)
+			return a.node->N < b.node->N;
+		return a.depth > b.depth;
+	});
+
+	int target = node_budget / 4 * 3;
+	auto end = candidates.end();
+	for(auto it = candidates.begin(); it!=end && *tree_nodes > target; it++) {
+		if(deadline != NULL && (it - candidates.begin()) % 1024 == 0 && chrono::steady_clock::now() >= *deadline)
+			break;
+		onode *on = it->node;
+		anode *father = on->father;
+		int freed = onode_count(on);
+		father->observations.erase(on->observation_index);
+		*tree_nodes -= freed;
+		*evictions += 1;
+		*evicted_nodes += freed;
+	}
+}
+
 /*
   Version 1: Choose actions randomly with uniform distribution
   Version 2: Apply the optimization for a static server count and roll out.
@@ -109,7 +166,8 @@ float Rollout(int state, onode *h, const vec *initial_belief, int n, mat *ims) {
 	return value;
 }
 
-float Simulate(int state, onode *h, const vec *initial_belief, int n, mat *ims) {
+/* tree_nodes: node count of the tree h belongs to, updated on expansion (may be NULL). */
+float Simulate(int state, onode *h, const vec *initial_belief, int n, mat *ims, int *tree_nodes) {
 	if(n == 0) return 0.0;
 
 	// if no children exist
@@ -123,6 +181,8 @@ float Simulate(int state, onode *h, const vec *initial_belief, int n, mat *ims)
 			if(vstatic > best_vstatic)
 				best_vstatic = vstatic;
 		}
+		if(tree_nodes != NULL)
+			*tree_nodes += action_count;
 		return best_vstatic; //Rollout(state, h, initial_belief, n, ims);
 	}
 
@@ -149,11 +209,14 @@ float Simulate(int state, onode *h, const vec *initial_belief, int n, mat *ims)
 	float immediate_value = (float)improvement - ((float)best_action*server_cost);
 
 	auto hao_iter = best_action_node->observations.find(improvement);
-	if(hao_iter == best_action_node->observations.end()) // not found
+	if(hao_iter == best_action_node->observations.end()) { // not found
 		hao_iter = best_action_node->observations.insert(pair<int, onode>(improvement, {improvement, 0, map<int, anode>(), best_action_node})).first; // improvement_index, N, actions, father
+		if(tree_nodes != NULL)
+			*tree_nodes += 1;
+	}
 	onode *hao = &hao_iter->second;
 
-	float R = immediate_value + Simulate(new_state, hao, initial_belief, n-1, ims);
+	float R = immediate_value + Simulate(new_state, hao, initial_belief, n-1, ims, tree_nodes);
 	h->N += 1;
 	best_action_node->N += 1;
 	best_action_node->V += (R - best_action_node->V) / (float)best_action_node->N;
@@ -161,18 +224,30 @@ float Simulate(int state, onode *h, const vec *initial_belief, int n, mat *ims)
 	return R;
 }
 
-utc_result Search(int periods, const vec *initial_belief, mat *ims) {
+/* Runs N iterations, or as many as fit into the wall-clock budget if seconds > 0.
+   A timed search does not record the convergence, to keep its footprint fixed. */
+utc_result Search(int periods, const vec *initial_belief, mat *ims, double seconds) {
 	onode *h_root = new (onode){0, 0, map<int, anode>(), NULL}; // observation_index, N, actions, father
+	int tree_nodes = 1;
 	int N = 200000;
-	vec convergence(N);
+	vec convergence(seconds > 0.0 ? 0 : N);
+	int evictions = 0;
+	int evicted_nodes = 0;
+	chrono::steady_clock::time_point deadline = chrono::steady_clock::now()
+		+ chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(seconds));
 	
 	int best_action = -1;
 	float best_value = -100000000.0;
-	for(int i=0;i<N;i++) {
-		if(i%1000 == 0)
+	int i;
+	for(i=0; seconds > 0.0 || i<N; i++) {
+		if(seconds > 0.0 && chrono::steady_clock::now() >= deadline)
+			break;
+		if(seconds <= 0.0 && i%1000 == 0) // no progress output inside a time budget
 			cout << i << endl;
 		int state = random_draw(initial_belief->memptr(), initial_belief->n_elem);
-		Simulate(state, h_root, initial_belief, periods, ims);
+		Simulate(state, h_root, initial_belief, periods, ims, &tree_nodes);
+		if(node_budget > 0 && tree_nodes > node_budget)
+			evict(h_root, &tree_nodes, &evictions, &evicted_nodes, seconds > 0.0 ? &deadline : NULL);
 		best_action = -1;
 		best_value = -100000000.0;
 		for (int l=0; l<action_count; l++) {
@@ -183,7 +258,8 @@ utc_result Search(int periods, const vec *initial_belief, mat *ims) {
 				best_value = value;
 			}
 		}
-		convergence.at(i) = best_value;
+		if(seconds <= 0.0)
+			convergence.at(i) = best_value;
 	}
 
 	best_action = -1;
@@ -202,6 +278,9 @@ utc_result Search(int periods, const vec *initial_belief, mat *ims) {
 	res.best_action = best_action;
 	res.best_value = best_value;
 	res.convergence = convergence;
+	res.nodes = tree_nodes;
+	res.evictions = evictions;
+	res.evicted_nodes = evicted_nodes;
 	return res;
 }
 
@@ -241,7 +320,7 @@ vec MC_utc(onode *h_root, vec *initial_belief, mat *ims, int periods) {
 				vec current_belief = update_history_belief(best_action_node->father, initial_belief, ims);
 				for(int i=0;i<N2;i++) {
 					int state = random_draw(current_belief.memptr(), initial_belief->n_elem);
-					Simulate(state, best_action_node->father, &current_belief, n, ims);
+					Simulate(state, best_action_node->father, &current_belief, n, ims, NULL);
 				}
 			}
 
@@ -258,7 +337,7 @@ vec MC_utc(onode *h_root, vec *initial_belief, mat *ims, int periods) {
 							vec current_belief = update_history_belief(best_action_node->father, initial_belief, ims);
 							for(int i=0;i<N2;i++) {
 								int state = random_draw(current_belief.memptr(), initial_belief->n_elem);
-								Simulate(state, best_action_node->father, &current_belief, n, ims);
+								Simulate(state, best_action_node->father, &current_belief, n, ims, NULL);
 							}
 							counter++;
 							if(counter % 100 == 0) {
@@ -29,10 +29,13 @@ typedef struct utc_result_t {
 	onode *root;
 	int best_action;
 	float best_value;
-	vec convergence; // the optimum value we have found in every period..
+	vec convergence; // the optimum value we have found in every period.. (empty for a timed search)
+	int nodes; // tree size (onodes + anodes) after the search
+	int evictions; // subtrees pruned to stay within node_budget
+	int evicted_nodes; // nodes freed by the evictions
 } utc_result;
 
-utc_result Search(int periods, const vec *initial_belief, mat *ims);
+utc_result Search(int periods, const vec *initial_belief, mat *ims, double seconds = 0.0);
 vec MC_utc(onode *h_root, vec *initial_belief, mat *ims, int periods);
 void onode_show_N(onode *node);
 